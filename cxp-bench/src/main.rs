@@ -0,0 +1,463 @@
+//! Benchmark harness for the vector index behind cxp-core's `search`
+//! feature.
+//!
+//! Drives the index end-to-end — sequential, batched and concurrent
+//! `add` throughput, `search` latency percentiles with traversal stats,
+//! recall against `exact_search` ground truth, the batched / cached /
+//! asynchronous query paths, `tune_expansion`, and the two-stage binary
+//! prefilter over a `fork` of each built graph — across the embedding
+//! dimensions CXP ships (384/768/1536), every quantization level, and a
+//! sweep of connectivity / expansion settings. Emits one JSON document
+//! on stdout so CI can diff runs and gate deployments on regressions.
+
+use std::time::Instant;
+
+use anyhow::{ensure, Context, Result};
+use clap::Parser;
+use serde::Serialize;
+use usearch::{Index, IndexOptions, MetricKind, ScalarKind, SearchStats};
+
+#[derive(Parser)]
+#[command(name = "cxp-bench", about = "Benchmark the CXP vector index")]
+struct Args {
+    /// Number of vectors inserted per configuration.
+    #[arg(long, default_value_t = 10_000)]
+    vectors: usize,
+
+    /// Number of search queries per configuration.
+    #[arg(long, default_value_t = 200)]
+    queries: usize,
+
+    /// Matches requested per query (recall is measured at this depth).
+    #[arg(long, default_value_t = 10)]
+    k: usize,
+
+    /// Dimensions to benchmark.
+    #[arg(long, value_delimiter = ',', default_values_t = vec![384, 768, 1536])]
+    dims: Vec<usize>,
+
+    /// Graph connectivity values to benchmark (0 = library default).
+    #[arg(long, value_delimiter = ',', default_values_t = vec![0])]
+    connectivity: Vec<usize>,
+
+    /// Insertion-time expansion factors (0 = library default).
+    #[arg(long, value_delimiter = ',', default_values_t = vec![0])]
+    expansion_add: Vec<usize>,
+
+    /// Search-time expansion factors swept per built index.
+    #[arg(long, value_delimiter = ',', default_values_t = vec![16, 64, 128])]
+    expansion_search: Vec<usize>,
+
+    /// Writer threads for the concurrent-ingest phase.
+    #[arg(long, default_value_t = 4)]
+    writers: usize,
+
+    /// Candidate oversampling factor for the two-stage phase.
+    #[arg(long, default_value_t = 4)]
+    oversample: usize,
+
+    /// Seed for the deterministic synthetic dataset.
+    #[arg(long, default_value_t = 42)]
+    seed: u64,
+}
+
+#[derive(Serialize)]
+struct Record {
+    dimensions: usize,
+    quantization: String,
+    connectivity: usize,
+    expansion_add: usize,
+    expansion_search: usize,
+    vectors: usize,
+    queries: usize,
+    k: usize,
+    kernel_isa: String,
+    add_vectors_per_sec: f64,
+    batch_add_vectors_per_sec: f64,
+    concurrent_add_vectors_per_sec: f64,
+    search_p50_us: f64,
+    search_p95_us: f64,
+    search_p99_us: f64,
+    visited_members_mean: f64,
+    computed_distances_mean: f64,
+    recall: f64,
+    batched_queries_per_sec: f64,
+    cached_hit_p50_us: f64,
+    async_queries_per_sec: f64,
+    tuned_expansion: usize,
+    /// Only measured on f32 configurations; the binary shadow quantizes
+    /// from f32 storage.
+    #[serde(skip_serializing_if = "Option::is_none")]
+    two_stage_p50_us: Option<f64>,
+    #[serde(skip_serializing_if = "Option::is_none")]
+    two_stage_recall: Option<f64>,
+    vector_bytes: usize,
+    graph_bytes: usize,
+    keymap_bytes: usize,
+    reclaimable_bytes: usize,
+}
+
+#[derive(Serialize)]
+struct Report {
+    seed: u64,
+    hardware_acceleration: String,
+    results: Vec<Record>,
+}
+
+/// SplitMix64: deterministic across platforms, no extra dependency.
+struct Rng(u64);
+
+impl Rng {
+    fn next(&mut self) -> u64 {
+        self.0 = self.0.wrapping_add(0x9E3779B97F4A7C15);
+        let mut z = self.0;
+        z = (z ^ (z >> 30)).wrapping_mul(0xBF58476D1CE4E5B9);
+        z = (z ^ (z >> 27)).wrapping_mul(0x94D049BB133111EB);
+        z ^ (z >> 31)
+    }
+
+    /// Uniform in [-1, 1); coarse enough to survive every quantization.
+    fn unit(&mut self) -> f32 {
+        (self.next() >> 40) as f32 / (1u64 << 23) as f32 * 2.0 - 1.0
+    }
+
+    fn matrix(&mut self, rows: usize, dimensions: usize) -> Vec<f32> {
+        (0..rows * dimensions).map(|_| self.unit()).collect()
+    }
+}
+
+fn percentile(sorted_us: &[f64], fraction: f64) -> f64 {
+    if sorted_us.is_empty() {
+        return 0.0;
+    }
+    let rank = ((sorted_us.len() - 1) as f64 * fraction).round() as usize;
+    sorted_us[rank]
+}
+
+fn recall_at_k(found: &[u64], expected: &[u64]) -> f64 {
+    if expected.is_empty() {
+        return 1.0;
+    }
+    let hits = expected.iter().filter(|key| found.contains(key)).count();
+    hits as f64 / expected.len() as f64
+}
+
+fn quantizations() -> Vec<(ScalarKind, &'static str)> {
+    vec![
+        (ScalarKind::F64, "f64"),
+        (ScalarKind::F32, "f32"),
+        (ScalarKind::F16, "f16"),
+        (ScalarKind::BF16, "bf16"),
+        (ScalarKind::I8, "i8"),
+    ]
+}
+
+fn make_index(options: &IndexOptions, capacity: usize) -> Result<Index> {
+    let index = Index::new(options).context("failed to create index")?;
+    index.reserve(capacity).context("failed to reserve")?;
+    Ok(index)
+}
+
+/// Single-call ingest of the whole dataset through `add_batch`.
+fn bench_batch_add(options: &IndexOptions, data: &[f32], dimensions: usize) -> Result<f64> {
+    let rows = data.len() / dimensions;
+    let index = make_index(options, rows)?;
+    let keys: Vec<u64> = (0..rows as u64).collect();
+    let started = Instant::now();
+    index.add_batch(&keys, data).context("batch add failed")?;
+    Ok(rows as f64 / started.elapsed().as_secs_f64())
+}
+
+/// Multi-threaded ingest through `enable_concurrent_writes` + `try_add`.
+fn bench_concurrent_add(
+    options: &IndexOptions,
+    data: &[f32],
+    dimensions: usize,
+    writers: usize,
+) -> Result<f64> {
+    let rows = data.len() / dimensions;
+    let index = Index::new(options).context("failed to create index")?;
+    // One insertion context per writer; the defaults size the pool to the
+    // machine's core count, which may be below `writers`.
+    index
+        .reserve_capacity_and_threads(rows, writers)
+        .context("failed to reserve")?;
+    index
+        .enable_concurrent_writes()
+        .context("failed to enable concurrent writes")?;
+    let started = Instant::now();
+    let rejected = std::thread::scope(|scope| {
+        let mut workers = Vec::with_capacity(writers);
+        for worker in 0..writers {
+            let index = &index;
+            workers.push(scope.spawn(move || {
+                let mut rejected = 0usize;
+                for row in (worker..rows).step_by(writers) {
+                    let vector = &data[row * dimensions..(row + 1) * dimensions];
+                    rejected += !index.try_add(row as u64, vector) as usize;
+                }
+                rejected
+            }));
+        }
+        workers.into_iter().map(|w| w.join().unwrap()).sum::<usize>()
+    });
+    let elapsed = started.elapsed().as_secs_f64();
+    ensure!(rejected == 0, "{rejected} concurrent inserts were rejected");
+    ensure!(index.pending_writes() == 0, "writes left pending");
+    Ok(rows as f64 / elapsed)
+}
+
+/// Drives the whole query set through `submit_search`/`poll_completions`
+/// and returns the end-to-end throughput.
+fn bench_async_search(index: &Index, queries: &[f32], dimensions: usize, k: usize) -> Result<f64> {
+    let total = queries.len() / dimensions;
+    let started = Instant::now();
+    for (ticket, query) in queries.chunks(dimensions).enumerate() {
+        index
+            .submit_search(ticket as u64, query, k)
+            .context("failed to submit search")?;
+    }
+    let mut tickets = vec![0u64; total];
+    let mut counts = vec![0u64; total];
+    let mut keys = vec![0u64; total * k];
+    let mut distances = vec![0f32; total * k];
+    let mut drained = 0;
+    while drained != total {
+        drained += index
+            .poll_completions(&mut tickets, &mut counts, &mut keys, &mut distances)
+            .context("failed to poll completions")?;
+    }
+    Ok(total as f64 / started.elapsed().as_secs_f64())
+}
+
+/// Two-stage search over a `fork` of the built graph, so the shadow
+/// back-fill doesn't disturb the index the other phases measure.
+fn bench_two_stage(
+    index: &Index,
+    queries: &[f32],
+    dimensions: usize,
+    k: usize,
+    oversample: usize,
+    ground_truth: &[Vec<u64>],
+) -> Result<(f64, f64)> {
+    let forked = index.fork().context("failed to fork index")?;
+    forked
+        .enable_two_stage(oversample)
+        .context("failed to enable two-stage search")?;
+    let mut latencies_us = Vec::with_capacity(ground_truth.len());
+    let mut recall_sum = 0.0;
+    for (query, expected) in queries.chunks(dimensions).zip(ground_truth) {
+        let started = Instant::now();
+        let matches = forked.search(query, k).context("two-stage search failed")?;
+        latencies_us.push(started.elapsed().as_secs_f64() * 1e6);
+        recall_sum += recall_at_k(&matches.keys, expected);
+    }
+    latencies_us.sort_by(|a, b| a.total_cmp(b));
+    let recall = recall_sum / ground_truth.len() as f64;
+    Ok((percentile(&latencies_us, 0.50), recall))
+}
+
+#[allow(clippy::too_many_arguments)]
+fn bench_one(
+    args: &Args,
+    dimensions: usize,
+    quantization: ScalarKind,
+    quantization_name: &str,
+    connectivity: usize,
+    expansion_add: usize,
+    data: &[f32],
+    queries: &[f32],
+    results: &mut Vec<Record>,
+) -> Result<String> {
+    // Spelling the remaining fields through `Default` keeps this in sync
+    // with the bridge-defined struct as options are added (`force_isa`,
+    // `numa_mode`, ...).
+    let options = IndexOptions {
+        dimensions,
+        metric: MetricKind::Cos,
+        quantization,
+        connectivity,
+        expansion_add,
+        ..Default::default()
+    };
+
+    let index = make_index(&options, args.vectors)?;
+    let started = Instant::now();
+    for row in 0..args.vectors {
+        let vector = &data[row * dimensions..(row + 1) * dimensions];
+        index
+            .add(row as u64, vector)
+            .with_context(|| format!("failed to add vector {row}"))?;
+    }
+    let add_vectors_per_sec = args.vectors as f64 / started.elapsed().as_secs_f64();
+
+    let batch_add_vectors_per_sec = bench_batch_add(&options, data, dimensions)?;
+    let concurrent_add_vectors_per_sec =
+        bench_concurrent_add(&options, data, dimensions, args.writers)?;
+
+    // Touch the vector arena before the timed query phases, the same way
+    // a deployment would prefault a freshly viewed image.
+    index.warmup(usize::MAX).context("warmup failed")?;
+
+    // Ground truth is brute force over the same (quantized) storage, so
+    // recall isolates graph quality from quantization error.
+    let mut ground_truth = Vec::with_capacity(args.queries);
+    for query in queries.chunks(dimensions) {
+        let exact = index
+            .exact_search(query, args.k)
+            .context("exact search failed")?;
+        ground_truth.push(exact.keys);
+    }
+
+    let memory = index.memory_report().context("memory report failed")?;
+    let kernel_isa = index.kernel_isa(options.metric, quantization);
+
+    for &expansion_search in &args.expansion_search {
+        if expansion_search != 0 {
+            index.change_expansion_search(expansion_search);
+        }
+
+        let mut latencies_us = Vec::with_capacity(args.queries);
+        let mut recall_sum = 0.0;
+        let mut visited = 0usize;
+        let mut computed = 0usize;
+        for (query, expected) in queries.chunks(dimensions).zip(&ground_truth) {
+            let mut stats = SearchStats::default();
+            let started = Instant::now();
+            let matches = index
+                .search_with_stats(query, args.k, &mut stats)
+                .context("search failed")?;
+            latencies_us.push(started.elapsed().as_secs_f64() * 1e6);
+            recall_sum += recall_at_k(&matches.keys, expected);
+            visited += stats.visited_members;
+            computed += stats.computed_distances;
+        }
+        latencies_us.sort_by(|a, b| a.total_cmp(b));
+
+        // One crossing for the whole block; rows come back flattened at a
+        // fixed stride of `k`.
+        let started = Instant::now();
+        let block = index
+            .search_many(queries, args.k)
+            .context("batched search failed")?;
+        let batched_queries_per_sec = args.queries as f64 / started.elapsed().as_secs_f64();
+        ensure!(block.keys.len() == args.queries * args.k, "short batch");
+
+        // Prime the result cache with one pass, then measure pure hits.
+        index
+            .enable_search_cache(args.queries, 0)
+            .context("failed to enable search cache")?;
+        for query in queries.chunks(dimensions) {
+            index
+                .search_cached(query, args.k)
+                .context("cache priming failed")?;
+        }
+        let mut hit_latencies_us = Vec::with_capacity(args.queries);
+        for query in queries.chunks(dimensions) {
+            let started = Instant::now();
+            index
+                .search_cached(query, args.k)
+                .context("cached search failed")?;
+            hit_latencies_us.push(started.elapsed().as_secs_f64() * 1e6);
+        }
+        hit_latencies_us.sort_by(|a, b| a.total_cmp(b));
+        index
+            .disable_search_cache()
+            .context("failed to disable search cache")?;
+
+        let async_queries_per_sec = bench_async_search(&index, queries, dimensions, args.k)?;
+
+        let tuned_expansion = index
+            .tune_expansion(queries, args.k, 0.95)
+            .context("expansion tuning failed")?;
+        // Tuning leaves its chosen expansion installed; restore the swept
+        // value so the next iteration measures what it claims to.
+        if expansion_search != 0 {
+            index.change_expansion_search(expansion_search);
+        }
+
+        let (two_stage_p50_us, two_stage_recall) = if quantization == ScalarKind::F32 {
+            let (p50, recall) = bench_two_stage(
+                &index,
+                queries,
+                dimensions,
+                args.k,
+                args.oversample,
+                &ground_truth,
+            )?;
+            (Some(p50), Some(recall))
+        } else {
+            (None, None)
+        };
+
+        results.push(Record {
+            dimensions,
+            quantization: quantization_name.to_string(),
+            connectivity,
+            expansion_add,
+            expansion_search,
+            vectors: args.vectors,
+            queries: args.queries,
+            k: args.k,
+            kernel_isa: kernel_isa.clone(),
+            add_vectors_per_sec,
+            batch_add_vectors_per_sec,
+            concurrent_add_vectors_per_sec,
+            search_p50_us: percentile(&latencies_us, 0.50),
+            search_p95_us: percentile(&latencies_us, 0.95),
+            search_p99_us: percentile(&latencies_us, 0.99),
+            visited_members_mean: visited as f64 / args.queries as f64,
+            computed_distances_mean: computed as f64 / args.queries as f64,
+            recall: recall_sum / args.queries as f64,
+            batched_queries_per_sec,
+            cached_hit_p50_us: percentile(&hit_latencies_us, 0.50),
+            async_queries_per_sec,
+            tuned_expansion,
+            two_stage_p50_us,
+            two_stage_recall,
+            vector_bytes: memory.vector_bytes,
+            graph_bytes: memory.graph_bytes,
+            keymap_bytes: memory.keymap_bytes,
+            reclaimable_bytes: memory.reclaimable_bytes,
+        });
+    }
+
+    Ok(index.hardware_acceleration())
+}
+
+fn main() -> Result<()> {
+    let args = Args::parse();
+    let mut rng = Rng(args.seed);
+    let mut results = Vec::new();
+    let mut hardware_acceleration = String::new();
+
+    for &dimensions in &args.dims {
+        let data = rng.matrix(args.vectors, dimensions);
+        let queries = rng.matrix(args.queries, dimensions);
+        for (quantization, quantization_name) in quantizations() {
+            for &connectivity in &args.connectivity {
+                for &expansion_add in &args.expansion_add {
+                    hardware_acceleration = bench_one(
+                        &args,
+                        dimensions,
+                        quantization,
+                        quantization_name,
+                        connectivity,
+                        expansion_add,
+                        &data,
+                        &queries,
+                        &mut results,
+                    )?;
+                }
+            }
+        }
+    }
+
+    let report = Report {
+        seed: args.seed,
+        hardware_acceleration,
+        results,
+    };
+    println!("{}", serde_json::to_string_pretty(&report)?);
+    Ok(())
+}